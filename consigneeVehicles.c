@@ -1,6 +1,22 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#ifdef WASM_STORE
+    #ifdef __EMSCRIPTEN__
+        #include <emscripten.h>
+    #else
+        #define EMSCRIPTEN_KEEPALIVE
+    #endif
+    #ifdef __wasm_simd128__
+        #include <wasm_simd128.h>
+    #endif
+#endif
 
 /**
  * @file consigneeVehicles.c
@@ -21,6 +37,97 @@ typedef struct {
     char type; // P for ownend, C for consigned
 } Vehicle;
 
+#define TDIGEST_COMPRESSION 100
+#define TDIGEST_CAPACITY (TDIGEST_COMPRESSION + 1)
+#define TDIGEST_BUFFER_SIZE (TDIGEST_COMPRESSION * 2)
+
+#define GROUP_BY_BRAND 1
+#define GROUP_BY_MODEL 2
+#define GROUP_BY_YEAR 4
+#define GROUP_BY_TYPE 8
+#define GROUP_BY_STATE 16
+
+#define GROUP_TABLE_INITIAL_SIZE 64
+#define GROUP_PENDING_SIZE 4096
+#define GROUP_PENDING_PER_GROUP 64
+#define SCAN_BLOCK_SIZE 1024
+
+/**
+ * A centroid of a t-digest: the mean of a cluster of values and how many
+ * values it represents.
+ */
+typedef struct {
+    double mean;
+    double weight;
+} Centroid;
+
+/**
+ * Mergeable quantile sketch (merging t-digest) over vehicle values.
+ *
+ * Values are added in batches and folded right away into at most
+ * TDIGEST_CAPACITY centroids, so the memory used is fixed no matter how
+ * many values are added.
+ */
+typedef struct {
+    Centroid centroids[TDIGEST_CAPACITY];
+    int centroidCount;
+    double totalWeight;
+    double min;
+    double max;
+} TDigest;
+
+/**
+ * The fields a group is keyed on. Fields not selected in the group-by mask
+ * are left zeroed so they do not split the groups.
+ */
+typedef struct {
+    char brand[20];
+    char model[20];
+    int year;
+    char type;
+    char state;
+} GroupKey;
+
+/**
+ * Aggregated values of the vehicles that share a GroupKey.
+ */
+typedef struct {
+    GroupKey key;
+    int id;
+    int count;
+    double sum;
+    double min;
+    double max;
+    TDigest digest;
+} Group;
+
+/**
+ * A value waiting to be added to the t-digest of its group.
+ */
+typedef struct {
+    int groupId;
+    double value;
+} PendingValue;
+
+/**
+ * Open addressing hash table of groups, keyed on the fields in groupBy.
+ * The groups are also listed by id, in the order they were created.
+ *
+ * The values of every group are staged in one shared pending buffer and
+ * added to the t-digests when it fills, so a group does not
+ * need a staging buffer of its own.
+ */
+typedef struct {
+    Group** slots;
+    Group** groups;
+    int size;
+    int count;
+    int groupBy;
+    PendingValue* pending;
+    int pendingCount;
+    int pendingSize;
+} GroupTable;
+
 /**
  * Searches for a vehicle in the main file by its number plate.
  *
@@ -130,6 +237,252 @@ void clearScreen();
  */
 void getTotal(FILE* mainFile);
 
+/**
+ * Initializes an empty t-digest.
+ *
+ * @param digest The t-digest to initialize.
+ */
+void tdigestInit(TDigest* digest);
+
+/**
+ * Adds a batch of values to a t-digest and folds them into its centroids.
+ *
+ * @param digest The t-digest to add the values to.
+ * @param added The values to add, as centroids (weight 1 for a single vehicle).
+ * @param count The number of centroids to add.
+ */
+void tdigestAdd(TDigest* digest, Centroid* added, int count);
+
+/**
+ * Merges a t-digest into another one, e.g. the partial results of two
+ * threads or two files.
+ *
+ * @param digest The t-digest that receives the values.
+ * @param other The t-digest to merge in. It is not changed.
+ */
+void tdigestMerge(TDigest* digest, TDigest* other);
+
+/**
+ * Estimates a quantile of the values added to a t-digest.
+ *
+ * @param digest The t-digest to query.
+ * @param q The quantile to estimate, between 0 and 1 (0.5 for the median).
+ * @return The estimated value, or 0 if the t-digest is empty.
+ */
+double tdigestQuantile(TDigest* digest, double q);
+
+/**
+ * Creates an empty group table.
+ *
+ * @param groupBy The fields to group by, a combination of the GROUP_BY_* flags.
+ * @return A pointer to the new group table.
+ */
+GroupTable* createGroupTable(int groupBy);
+
+/**
+ * Frees a group table and all of its groups.
+ *
+ * @param table The group table to free.
+ */
+void freeGroupTable(GroupTable* table);
+
+/**
+ * Adds a vehicle to the group it belongs to, creating the group if needed.
+ *
+ * @param table The group table.
+ * @param vehicle The vehicle to add.
+ */
+void groupVehicle(GroupTable* table, Vehicle* vehicle);
+
+/**
+ * Adds the pending values of a group table to the t-digests of their groups.
+ *
+ * @param table The group table to flush.
+ */
+void flushGroupTable(GroupTable* table);
+
+/**
+ * Merges the groups of a table into another table with the same groupBy.
+ *
+ * @param table The group table that receives the groups.
+ * @param other The group table to merge in.
+ * @return int Returns 1 if the tables were merged, 0 if their groupBy differ.
+ */
+int mergeGroupTables(GroupTable* table, GroupTable* other);
+
+/**
+ * Groups the vehicles of the main file in a single scan.
+ *
+ * Only active vehicles are grouped, unless the state is one of the
+ * group-by fields, in which case every vehicle is grouped.
+ *
+ * @param mainFile The file pointer to the main file.
+ * @param groupBy The fields to group by, a combination of the GROUP_BY_* flags.
+ * @return A pointer to the group table with the results.
+ */
+GroupTable* groupVehicles(FILE* mainFile, int groupBy);
+
+/**
+ * Prints the count, sum, min, max, median and p90 value of every group.
+ *
+ * @param table The group table to print.
+ */
+void printGroupTable(GroupTable* table);
+
+#ifdef WASM_STORE
+
+#define STORE_INITIAL_CAPACITY 1024
+
+/**
+ * In-memory vehicle store used by the WebAssembly build (-DWASM_STORE).
+ *
+ * The records live in one array in linear memory, with the value, state and
+ * type also kept in columns so the scans can run 2 values or 16 states and
+ * types at a time with WASM SIMD. Changes only reach the file on storeFlush.
+ * The number plates are indexed in an open addressing hash table whose
+ * slots hold the index of the vehicle plus one (0 for an empty slot).
+ */
+typedef struct {
+    Vehicle* vehicles;
+    double* values;
+    char* states;
+    char* types;
+    int* results;
+    int* plateSlots;
+    int count;
+    int capacity;
+    int dirty;
+    double totals[4];
+} VehicleStore;
+
+/**
+ * Loads the vehicles of a file into the store, replacing its contents.
+ *
+ * @param path The path of the file, e.g. vehicles.dat.
+ * @return The number of vehicles loaded, 0 if the file does not exist.
+ */
+int storeLoad(const char* path);
+
+/**
+ * Writes every vehicle of the store to a file, if anything changed since
+ * the last load or flush. The vehicles are written to path.tmp first and
+ * renamed over the file, so a failed write leaves the file as it was and
+ * the store still dirty. In the browser, call FS.syncfs afterwards to
+ * persist an IDBFS mount to IndexedDB.
+ *
+ * @param path The path of the file, e.g. vehicles.dat.
+ * @return int Returns 1 if the file was written, 0 if nothing changed and -1 if it could not be written.
+ */
+int storeFlush(const char* path);
+
+/**
+ * Gets the number of vehicles in the store.
+ *
+ * @return The number of vehicles, active or not.
+ */
+int storeCount();
+
+/**
+ * Gets a vehicle of the store, to be read from linear memory.
+ *
+ * @param index The index of the vehicle, as returned by the searches.
+ * @return A pointer to the vehicle, or NULL if the index is out of range.
+ */
+Vehicle* storeVehicle(int index);
+
+/**
+ * Gets the indices found by the last search.
+ *
+ * @return A pointer to the indices, as many as the search returned.
+ */
+int* storeResults();
+
+/**
+ * Appends a vehicle to the store.
+ *
+ * @param numberPlate The number plate of the vehicle.
+ * @param brand The brand of the vehicle.
+ * @param model The model of the vehicle.
+ * @param year The year of the vehicle.
+ * @param color The color of the vehicle.
+ * @param value The value of the vehicle.
+ * @param state The state of the vehicle (A active, E inactive).
+ * @param type The type of the vehicle (P own, C consigned).
+ * @return The index of the inserted vehicle, or -1 if its number plate is
+ *         already in the store (use storeUpdate to reactivate it).
+ */
+int storeInsert(const char* numberPlate, const char* brand, const char* model, int year, const char* color, double value, char state, char type);
+
+/**
+ * Searches for an active vehicle by its number plate.
+ *
+ * @param numberPlate The number plate of the vehicle to search for.
+ * @return The index of the vehicle, or -1 if not found.
+ */
+int storeSearchByNumberPlate(const char* numberPlate);
+
+/**
+ * Searches for the vehicles within a value range.
+ *
+ * @param minValue The minimum value for the vehicle.
+ * @param maxValue The maximum value for the vehicle.
+ * @return The number of vehicles found, whose indices are in storeResults.
+ */
+int storeSearchByValueRange(double minValue, double maxValue);
+
+/**
+ * Searches for the active vehicles of a brand and model.
+ *
+ * @param brand The brand of the vehicle to search for.
+ * @param model The model of the vehicle to search for.
+ * @return The number of vehicles found, whose indices are in storeResults.
+ */
+int storeSearchByBrandAndModel(const char* brand, const char* model);
+
+/**
+ * Searches for the vehicles of a type.
+ *
+ * @param type The type of vehicle to search for(P own, C consigned).
+ * @return The number of vehicles found, whose indices are in storeResults.
+ */
+int storeSearchByType(char type);
+
+/**
+ * Searches for the vehicles in a state.
+ *
+ * @param state The state to search for.
+ * @return The number of vehicles found, whose indices are in storeResults.
+ */
+int storeSearchByState(char state);
+
+/**
+ * Updates the value and state of a vehicle.
+ *
+ * @param numberPlate The number plate of the vehicle to update.
+ * @param value The new value of the vehicle.
+ * @param state The new state of the vehicle.
+ * @return int Returns 1 if the vehicle was updated, 0 if not found.
+ */
+int storeUpdate(const char* numberPlate, double value, char state);
+
+/**
+ * Removes a vehicle logically.
+ *
+ * @param numberPlate The number plate of the vehicle to remove.
+ * @return int Returns 1 if the vehicle was removed, 0 if not found.
+ */
+int storeRemove(const char* numberPlate);
+
+/**
+ * Gets the totals of the active vehicles, like getTotal.
+ *
+ * @return A pointer to 4 doubles: consigned vehicles, owned vehicles,
+ *         consigned total value and owned total value.
+ */
+double* storeTotal();
+
+#endif
+
 
 Vehicle* searchVehicleByNumberPlate(FILE* mainFile, char numberPlate[6], int returnAll) {
     Vehicle* vehicle = (Vehicle*) malloc(sizeof(Vehicle));
@@ -198,6 +551,405 @@ void getTotal(FILE* mainFile) {
 
 }
 
+void tdigestInit(TDigest* digest) {
+    digest->centroidCount = 0;
+    digest->totalWeight = 0;
+    digest->min = 0;
+    digest->max = 0;
+}
+
+int compareCentroids(const void* a, const void* b) {
+    double meanA = ((const Centroid*) a)->mean;
+    double meanB = ((const Centroid*) b)->mean;
+    return (meanA > meanB) - (meanA < meanB);
+}
+
+// Scale function k1 of the t-digest paper: centroids are small near the
+// tails and large near the median, so the extreme quantiles stay accurate.
+double tdigestScale(double q) {
+    return TDIGEST_COMPRESSION / (2 * M_PI) * asin(2 * q - 1);
+}
+
+double tdigestScaleInverse(double k) {
+    if (k >= TDIGEST_COMPRESSION / 4.0) {
+        return 1;
+    }
+    return (sin(k * 2 * M_PI / TDIGEST_COMPRESSION) + 1) / 2;
+}
+
+void tdigestAdd(TDigest* digest, Centroid* added, int count) {
+    Centroid batch[TDIGEST_BUFFER_SIZE];
+    Centroid all[TDIGEST_CAPACITY + TDIGEST_BUFFER_SIZE];
+    while (count > 0) {
+        int batchCount = count < TDIGEST_BUFFER_SIZE ? count : TDIGEST_BUFFER_SIZE;
+        memcpy(batch, added, sizeof(Centroid) * batchCount);
+        qsort(batch, batchCount, sizeof(Centroid), compareCentroids);
+        if (digest->totalWeight == 0 || batch[0].mean < digest->min) {
+            digest->min = batch[0].mean;
+        }
+        if (digest->totalWeight == 0 || batch[batchCount - 1].mean > digest->max) {
+            digest->max = batch[batchCount - 1].mean;
+        }
+        for (int i = 0; i < batchCount; i++) {
+            digest->totalWeight += batch[i].weight;
+        }
+
+        // The centroids are already sorted, so only the batch needs sorting
+        // and both are merged in one pass.
+        int n = 0;
+        int c = 0;
+        int b = 0;
+        while (c < digest->centroidCount || b < batchCount) {
+            if (b == batchCount || (c < digest->centroidCount && digest->centroids[c].mean <= batch[b].mean)) {
+                all[n++] = digest->centroids[c++];
+            } else {
+                all[n++] = batch[b++];
+            }
+        }
+
+        // Two neighbouring centroids always span more than one unit of the
+        // scale, so at most TDIGEST_CAPACITY centroids come out of here.
+        double total = digest->totalWeight;
+        double weightSoFar = 0;
+        double weightLimit = tdigestScaleInverse(tdigestScale(0) + 1) * total;
+        Centroid current = all[0];
+        digest->centroidCount = 0;
+        for (int i = 1; i < n; i++) {
+            if (weightSoFar + current.weight + all[i].weight <= weightLimit) {
+                current.weight += all[i].weight;
+                current.mean += (all[i].mean - current.mean) * all[i].weight / current.weight;
+            } else {
+                digest->centroids[digest->centroidCount++] = current;
+                weightSoFar += current.weight;
+                weightLimit = tdigestScaleInverse(tdigestScale(weightSoFar / total) + 1) * total;
+                current = all[i];
+            }
+        }
+        digest->centroids[digest->centroidCount++] = current;
+        added += batchCount;
+        count -= batchCount;
+    }
+}
+
+void tdigestMerge(TDigest* digest, TDigest* other) {
+    if (other->totalWeight == 0) {
+        return;
+    }
+    double min = other->min;
+    double max = other->max;
+    if (digest->totalWeight != 0) {
+        min = digest->min < min ? digest->min : min;
+        max = digest->max > max ? digest->max : max;
+    }
+    tdigestAdd(digest, other->centroids, other->centroidCount);
+    digest->min = min;
+    digest->max = max;
+}
+
+double tdigestQuantile(TDigest* digest, double q) {
+    if (digest->centroidCount == 0) {
+        return 0;
+    }
+    Centroid* centroids = digest->centroids;
+    int last = digest->centroidCount - 1;
+    double index = q * digest->totalWeight;
+
+    // Each centroid sits at the middle of its weight; interpolate between
+    // the neighbouring centers, and against min/max at both ends.
+    if (index < centroids[0].weight / 2) {
+        return digest->min + index / (centroids[0].weight / 2) * (centroids[0].mean - digest->min);
+    }
+    double cumulative = centroids[0].weight / 2;
+    for (int i = 0; i < last; i++) {
+        double step = (centroids[i].weight + centroids[i + 1].weight) / 2;
+        if (index < cumulative + step) {
+            return centroids[i].mean + (index - cumulative) / step * (centroids[i + 1].mean - centroids[i].mean);
+        }
+        cumulative += step;
+    }
+    double tail = (index - cumulative) / (centroids[last].weight / 2);
+    if (tail > 1) {
+        tail = 1;
+    }
+    return centroids[last].mean + tail * (digest->max - centroids[last].mean);
+}
+
+GroupTable* createGroupTable(int groupBy) {
+    GroupTable* table = (GroupTable*) malloc(sizeof(GroupTable));
+    table->slots = (Group**) calloc(GROUP_TABLE_INITIAL_SIZE, sizeof(Group*));
+    table->groups = (Group**) malloc(sizeof(Group*) * GROUP_TABLE_INITIAL_SIZE);
+    table->size = GROUP_TABLE_INITIAL_SIZE;
+    table->count = 0;
+    table->groupBy = groupBy;
+    table->pending = (PendingValue*) malloc(sizeof(PendingValue) * GROUP_PENDING_SIZE);
+    table->pendingCount = 0;
+    table->pendingSize = GROUP_PENDING_SIZE;
+    return table;
+}
+
+void freeGroupTable(GroupTable* table) {
+    for (int i = 0; i < table->size; i++) {
+        free(table->slots[i]);
+    }
+    free(table->slots);
+    free(table->groups);
+    free(table->pending);
+    free(table);
+}
+
+unsigned int hashBytes(unsigned int hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*) data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// FNV-1a over the key fields. The struct padding is left out, since it is
+// not guaranteed to be copied when a key is assigned. Keys are zeroed
+// before being filled, so the unused fields and the bytes after the end
+// of the brand and model hash the same for equal keys.
+unsigned int hashGroupKey(GroupKey* key) {
+    unsigned int hash = 2166136261u;
+    hash = hashBytes(hash, key->brand, sizeof(key->brand));
+    hash = hashBytes(hash, key->model, sizeof(key->model));
+    hash = hashBytes(hash, &key->year, sizeof(key->year));
+    hash = hashBytes(hash, &key->type, sizeof(key->type));
+    hash = hashBytes(hash, &key->state, sizeof(key->state));
+    return hash;
+}
+
+int groupKeysEqual(GroupKey* keyA, GroupKey* keyB) {
+    return memcmp(keyA->brand, keyB->brand, sizeof(keyA->brand)) == 0
+        && memcmp(keyA->model, keyB->model, sizeof(keyA->model)) == 0
+        && keyA->year == keyB->year
+        && keyA->type == keyB->type
+        && keyA->state == keyB->state;
+}
+
+void makeGroupKey(GroupKey* key, Vehicle* vehicle, int groupBy) {
+    memset(key, 0, sizeof(GroupKey));
+    if (groupBy & GROUP_BY_BRAND) {
+        strncpy(key->brand, vehicle->brand, sizeof(key->brand));
+    }
+    if (groupBy & GROUP_BY_MODEL) {
+        strncpy(key->model, vehicle->model, sizeof(key->model));
+    }
+    if (groupBy & GROUP_BY_YEAR) {
+        key->year = vehicle->year;
+    }
+    if (groupBy & GROUP_BY_TYPE) {
+        key->type = vehicle->type;
+    }
+    if (groupBy & GROUP_BY_STATE) {
+        key->state = vehicle->state;
+    }
+}
+
+/**
+ * Finds the group of a key, creating an empty one if it does not exist.
+ * The table doubles its size when it gets half full.
+ */
+Group* findOrCreateGroup(GroupTable* table, GroupKey* key) {
+    if ((table->count + 1) * 2 > table->size) {
+        int oldSize = table->size;
+        Group** oldSlots = table->slots;
+        table->size *= 2;
+        table->slots = (Group**) calloc(table->size, sizeof(Group*));
+        table->groups = (Group**) realloc(table->groups, sizeof(Group*) * table->size);
+        for (int i = 0; i < oldSize; i++) {
+            if (oldSlots[i] != NULL) {
+                unsigned int slot = hashGroupKey(&oldSlots[i]->key) & (table->size - 1);
+                while (table->slots[slot] != NULL) {
+                    slot = (slot + 1) & (table->size - 1);
+                }
+                table->slots[slot] = oldSlots[i];
+            }
+        }
+        free(oldSlots);
+    }
+    unsigned int slot = hashGroupKey(key) & (table->size - 1);
+    while (table->slots[slot] != NULL) {
+        if (groupKeysEqual(&table->slots[slot]->key, key)) {
+            return table->slots[slot];
+        }
+        slot = (slot + 1) & (table->size - 1);
+    }
+    Group* group = (Group*) malloc(sizeof(Group));
+    group->key = *key;
+    group->id = table->count;
+    group->count = 0;
+    group->sum = 0;
+    group->min = 0;
+    group->max = 0;
+    tdigestInit(&group->digest);
+    table->slots[slot] = group;
+    table->groups[table->count++] = group;
+    return group;
+}
+
+void groupVehicle(GroupTable* table, Vehicle* vehicle) {
+    GroupKey key;
+    makeGroupKey(&key, vehicle, table->groupBy);
+    Group* group = findOrCreateGroup(table, &key);
+    if (group->count == 0 || vehicle->value < group->min) {
+        group->min = vehicle->value;
+    }
+    if (group->count == 0 || vehicle->value > group->max) {
+        group->max = vehicle->value;
+    }
+    group->count++;
+    group->sum += vehicle->value;
+    if (table->pendingCount == table->pendingSize) {
+        flushGroupTable(table);
+        // Keep about GROUP_PENDING_PER_GROUP values per group in each flush,
+        // so that merging them into the centroids stays cheap with many groups.
+        if (table->pendingSize < table->count * GROUP_PENDING_PER_GROUP) {
+            table->pendingSize = table->count * GROUP_PENDING_PER_GROUP;
+            free(table->pending);
+            table->pending = (PendingValue*) malloc(sizeof(PendingValue) * table->pendingSize);
+        }
+    }
+    table->pending[table->pendingCount].groupId = group->id;
+    table->pending[table->pendingCount].value = vehicle->value;
+    table->pendingCount++;
+}
+
+void flushGroupTable(GroupTable* table) {
+    if (table->pendingCount == 0) {
+        return;
+    }
+    // Counting sort of the pending values by group id, so the values of
+    // each group are added to its t-digest in one call.
+    int* offsets = (int*) calloc(table->count + 1, sizeof(int));
+    Centroid* values = (Centroid*) malloc(sizeof(Centroid) * table->pendingCount);
+    for (int i = 0; i < table->pendingCount; i++) {
+        offsets[table->pending[i].groupId + 1]++;
+    }
+    for (int id = 0; id < table->count; id++) {
+        offsets[id + 1] += offsets[id];
+    }
+    for (int i = 0; i < table->pendingCount; i++) {
+        Centroid* value = &values[offsets[table->pending[i].groupId]++];
+        value->mean = table->pending[i].value;
+        value->weight = 1;
+    }
+    // offsets[id] is now where the values of the next group start.
+    int start = 0;
+    for (int id = 0; id < table->count; id++) {
+        if (offsets[id] > start) {
+            tdigestAdd(&table->groups[id]->digest, values + start, offsets[id] - start);
+        }
+        start = offsets[id];
+    }
+    free(offsets);
+    free(values);
+    table->pendingCount = 0;
+}
+
+int mergeGroupTables(GroupTable* table, GroupTable* other) {
+    if (table->groupBy != other->groupBy) {
+        return 0;
+    }
+    flushGroupTable(table);
+    flushGroupTable(other);
+    for (int i = 0; i < other->size; i++) {
+        Group* otherGroup = other->slots[i];
+        if (otherGroup == NULL || otherGroup->count == 0) {
+            continue;
+        }
+        Group* group = findOrCreateGroup(table, &otherGroup->key);
+        if (group->count == 0 || otherGroup->min < group->min) {
+            group->min = otherGroup->min;
+        }
+        if (group->count == 0 || otherGroup->max > group->max) {
+            group->max = otherGroup->max;
+        }
+        group->count += otherGroup->count;
+        group->sum += otherGroup->sum;
+        tdigestMerge(&group->digest, &otherGroup->digest);
+    }
+    return 1;
+}
+
+GroupTable* groupVehicles(FILE* mainFile, int groupBy) {
+    GroupTable* table = createGroupTable(groupBy);
+    Vehicle* block = (Vehicle*) malloc(sizeof(Vehicle) * SCAN_BLOCK_SIZE);
+    size_t read;
+    fseek(mainFile, 0, SEEK_SET);
+    while ((read = fread(block, sizeof(Vehicle), SCAN_BLOCK_SIZE, mainFile)) > 0) {
+        for (size_t i = 0; i < read; i++) {
+            if ((groupBy & GROUP_BY_STATE) || block[i].state == 'A') {
+                groupVehicle(table, &block[i]);
+            }
+        }
+    }
+    free(block);
+    flushGroupTable(table);
+    return table;
+}
+
+int compareGroups(const void* a, const void* b) {
+    GroupKey* keyA = &(*(Group* const*) a)->key;
+    GroupKey* keyB = &(*(Group* const*) b)->key;
+    int result = strncmp(keyA->brand, keyB->brand, sizeof(keyA->brand));
+    if (result == 0) {
+        result = strncmp(keyA->model, keyB->model, sizeof(keyA->model));
+    }
+    if (result == 0) {
+        result = (keyA->year > keyB->year) - (keyA->year < keyB->year);
+    }
+    if (result == 0) {
+        result = keyA->type - keyB->type;
+    }
+    if (result == 0) {
+        result = keyA->state - keyB->state;
+    }
+    return result;
+}
+
+void printGroupTable(GroupTable* table) {
+    flushGroupTable(table);
+    Group** groups = (Group**) malloc(sizeof(Group*) * (table->count + 1));
+    int count = 0;
+    for (int i = 0; i < table->size; i++) {
+        if (table->slots[i] != NULL) {
+            groups[count++] = table->slots[i];
+        }
+    }
+    qsort(groups, count, sizeof(Group*), compareGroups);
+    for (int i = 0; i < count; i++) {
+        Group* group = groups[i];
+        printf("* Group *\n");
+        if (table->groupBy & GROUP_BY_BRAND) {
+            printf("Brand: %.20s\n", group->key.brand);
+        }
+        if (table->groupBy & GROUP_BY_MODEL) {
+            printf("Model: %.20s\n", group->key.model);
+        }
+        if (table->groupBy & GROUP_BY_YEAR) {
+            printf("Year: %d\n", group->key.year);
+        }
+        if (table->groupBy & GROUP_BY_TYPE) {
+            printf("Type: %c\n", group->key.type);
+        }
+        if (table->groupBy & GROUP_BY_STATE) {
+            printf("State: %c\n", group->key.state);
+        }
+        printf("Vehicles: %d\n", group->count);
+        printf("Total value: %.2lf\n", group->sum);
+        printf("Min value: %.2lf\n", group->min);
+        printf("Max value: %.2lf\n", group->max);
+        printf("Median value: %.2lf\n", tdigestQuantile(&group->digest, 0.5));
+        printf("P90 value: %.2lf\n\n", tdigestQuantile(&group->digest, 0.9));
+    }
+    if (count == 0) {
+        printf("No vehicles found\n");
+    }
+    free(groups);
+}
+
 Vehicle* searchVehicleByType(FILE* mainFile, char type) {
     Vehicle* vehicle = (Vehicle*) malloc(sizeof(Vehicle));
     fseek(mainFile, 0, SEEK_SET);
@@ -308,6 +1060,337 @@ void clearScreen() {
 }
 
 
+#ifdef WASM_STORE
+
+VehicleStore store;
+
+void storeRebuildIndex();
+
+void storeEnsureCapacity(int capacity) {
+    if (capacity <= store.capacity) {
+        return;
+    }
+    int newCapacity = store.capacity == 0 ? STORE_INITIAL_CAPACITY : store.capacity;
+    while (newCapacity < capacity) {
+        newCapacity *= 2;
+    }
+    store.vehicles = (Vehicle*) realloc(store.vehicles, sizeof(Vehicle) * newCapacity);
+    store.values = (double*) realloc(store.values, sizeof(double) * newCapacity);
+    store.states = (char*) realloc(store.states, sizeof(char) * newCapacity);
+    store.types = (char*) realloc(store.types, sizeof(char) * newCapacity);
+    store.results = (int*) realloc(store.results, sizeof(int) * newCapacity);
+    store.plateSlots = (int*) realloc(store.plateSlots, sizeof(int) * newCapacity * 2);
+    store.capacity = newCapacity;
+    storeRebuildIndex();
+}
+
+// FNV-1a over the number plate, which is not NUL-terminated when it has
+// all 6 characters.
+unsigned int hashNumberPlate(const char* numberPlate) {
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < 6 && numberPlate[i] != '\0'; i++) {
+        hash ^= (unsigned char) numberPlate[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Adds a vehicle to the number plate index, unless its plate is already
+ * there, so the first vehicle with a plate is the one found.
+ */
+void storeIndexNumberPlate(int index) {
+    int mask = store.capacity * 2 - 1;
+    unsigned int slot = hashNumberPlate(store.vehicles[index].numberPlate) & mask;
+    while (store.plateSlots[slot] != 0) {
+        if (strncmp(store.vehicles[store.plateSlots[slot] - 1].numberPlate, store.vehicles[index].numberPlate, 6) == 0) {
+            return;
+        }
+        slot = (slot + 1) & mask;
+    }
+    store.plateSlots[slot] = index + 1;
+}
+
+void storeRebuildIndex() {
+    if (store.capacity == 0) {
+        return;
+    }
+    memset(store.plateSlots, 0, sizeof(int) * store.capacity * 2);
+    for (int i = 0; i < store.count; i++) {
+        storeIndexNumberPlate(i);
+    }
+}
+
+int storeFindNumberPlate(const char* numberPlate, int activeOnly) {
+    if (store.capacity == 0) {
+        return -1;
+    }
+    int mask = store.capacity * 2 - 1;
+    unsigned int slot = hashNumberPlate(numberPlate) & mask;
+    while (store.plateSlots[slot] != 0) {
+        int index = store.plateSlots[slot] - 1;
+        if (strncmp(store.vehicles[index].numberPlate, numberPlate, 6) == 0) {
+            return !activeOnly || store.states[index] == 'A' ? index : -1;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+/**
+ * Gets the length of a string, up to the size of the field it is copied
+ * into. Like the POSIX strnlen, which standard C does not have.
+ */
+size_t fieldLength(const char* text, size_t size) {
+    size_t length = 0;
+    while (length < size && text[length] != '\0') {
+        length++;
+    }
+    return length;
+}
+
+/**
+ * Puts in storeResults the indices whose byte in column equals wanted.
+ */
+int storeMatchByte(const char* column, char wanted) {
+    int found = 0;
+    int i = 0;
+#ifdef __wasm_simd128__
+    v128_t needle = wasm_i8x16_splat(wanted);
+    for (; i + 16 <= store.count; i += 16) {
+        unsigned int mask = wasm_i8x16_bitmask(wasm_i8x16_eq(wasm_v128_load(column + i), needle));
+        while (mask) {
+            store.results[found++] = i + __builtin_ctz(mask);
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < store.count; i++) {
+        if (column[i] == wanted) {
+            store.results[found++] = i;
+        }
+    }
+    return found;
+}
+
+EMSCRIPTEN_KEEPALIVE int storeLoad(const char* path) {
+    store.count = 0;
+    store.dirty = 0;
+    FILE* mainFile = fopen(path, "rb");
+    if (mainFile == NULL) {
+        storeRebuildIndex();
+        return 0;
+    }
+    fseek(mainFile, 0, SEEK_END);
+    int numberOfVehicles = ftell(mainFile) / sizeof(Vehicle);
+    fseek(mainFile, 0, SEEK_SET);
+    storeEnsureCapacity(numberOfVehicles);
+    store.count = fread(store.vehicles, sizeof(Vehicle), numberOfVehicles, mainFile);
+    fclose(mainFile);
+    for (int i = 0; i < store.count; i++) {
+        store.values[i] = store.vehicles[i].value;
+        store.states[i] = store.vehicles[i].state;
+        store.types[i] = store.vehicles[i].type;
+    }
+    storeRebuildIndex();
+    return store.count;
+}
+
+EMSCRIPTEN_KEEPALIVE int storeFlush(const char* path) {
+    if (!store.dirty) {
+        return 0;
+    }
+    char* tempPath = (char*) malloc(strlen(path) + 5);
+    strcpy(tempPath, path);
+    strcat(tempPath, ".tmp");
+    FILE* tempFile = fopen(tempPath, "wb");
+    if (tempFile == NULL) {
+        free(tempPath);
+        return -1;
+    }
+    int written = fwrite(store.vehicles, sizeof(Vehicle), store.count, tempFile) == (size_t) store.count;
+    if (fclose(tempFile) != 0) {
+        written = 0;
+    }
+    #ifdef WINDOWS
+        if (written) {
+            remove(path);
+        }
+    #endif
+    if (!written || rename(tempPath, path) != 0) {
+        remove(tempPath);
+        free(tempPath);
+        return -1;
+    }
+    free(tempPath);
+    store.dirty = 0;
+    return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int storeCount() {
+    return store.count;
+}
+
+EMSCRIPTEN_KEEPALIVE Vehicle* storeVehicle(int index) {
+    if (index < 0 || index >= store.count) {
+        return NULL;
+    }
+    return &store.vehicles[index];
+}
+
+EMSCRIPTEN_KEEPALIVE int* storeResults() {
+    return store.results;
+}
+
+EMSCRIPTEN_KEEPALIVE int storeInsert(const char* numberPlate, const char* brand, const char* model, int year, const char* color, double value, char state, char type) {
+    if (storeFindNumberPlate(numberPlate, 0) != -1) {
+        return -1;
+    }
+    storeEnsureCapacity(store.count + 1);
+    Vehicle* vehicle = &store.vehicles[store.count];
+    memset(vehicle, 0, sizeof(Vehicle));
+    memcpy(vehicle->numberPlate, numberPlate, fieldLength(numberPlate, sizeof(vehicle->numberPlate)));
+    memcpy(vehicle->brand, brand, fieldLength(brand, sizeof(vehicle->brand)));
+    memcpy(vehicle->model, model, fieldLength(model, sizeof(vehicle->model)));
+    vehicle->year = year;
+    memcpy(vehicle->color, color, fieldLength(color, sizeof(vehicle->color)));
+    vehicle->value = value;
+    vehicle->state = state;
+    vehicle->type = type;
+    store.values[store.count] = value;
+    store.states[store.count] = state;
+    store.types[store.count] = type;
+    storeIndexNumberPlate(store.count);
+    store.dirty = 1;
+    return store.count++;
+}
+
+EMSCRIPTEN_KEEPALIVE int storeSearchByNumberPlate(const char* numberPlate) {
+    return storeFindNumberPlate(numberPlate, 1);
+}
+
+EMSCRIPTEN_KEEPALIVE int storeSearchByValueRange(double minValue, double maxValue) {
+    int found = 0;
+    int i = 0;
+#ifdef __wasm_simd128__
+    v128_t min = wasm_f64x2_splat(minValue);
+    v128_t max = wasm_f64x2_splat(maxValue);
+    for (; i + 8 <= store.count; i += 8) {
+        unsigned int mask = 0;
+        for (int j = 0; j < 8; j += 2) {
+            v128_t value = wasm_v128_load(store.values + i + j);
+            v128_t inRange = wasm_v128_and(wasm_f64x2_ge(value, min), wasm_f64x2_le(value, max));
+            mask |= wasm_i64x2_bitmask(inRange) << j;
+        }
+        while (mask) {
+            store.results[found++] = i + __builtin_ctz(mask);
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < store.count; i++) {
+        if (store.values[i] >= minValue && store.values[i] <= maxValue) {
+            store.results[found++] = i;
+        }
+    }
+    return found;
+}
+
+EMSCRIPTEN_KEEPALIVE int storeSearchByBrandAndModel(const char* brand, const char* model) {
+    int active = storeMatchByte(store.states, 'A');
+    int found = 0;
+    for (int i = 0; i < active; i++) {
+        Vehicle* vehicle = &store.vehicles[store.results[i]];
+        if (strncmp(vehicle->brand, brand, 20) == 0 && strncmp(vehicle->model, model, 20) == 0) {
+            store.results[found++] = store.results[i];
+        }
+    }
+    return found;
+}
+
+EMSCRIPTEN_KEEPALIVE int storeSearchByType(char type) {
+    return storeMatchByte(store.types, type);
+}
+
+EMSCRIPTEN_KEEPALIVE int storeSearchByState(char state) {
+    return storeMatchByte(store.states, state);
+}
+
+EMSCRIPTEN_KEEPALIVE int storeUpdate(const char* numberPlate, double value, char state) {
+    int index = storeFindNumberPlate(numberPlate, 0);
+    if (index == -1) {
+        return 0;
+    }
+    store.vehicles[index].value = value;
+    store.vehicles[index].state = state;
+    store.values[index] = value;
+    store.states[index] = state;
+    store.dirty = 1;
+    return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE int storeRemove(const char* numberPlate) {
+    int index = storeFindNumberPlate(numberPlate, 0);
+    if (index == -1) {
+        return 0;
+    }
+    store.vehicles[index].state = 'E';
+    store.states[index] = 'E';
+    store.dirty = 1;
+    return 1;
+}
+
+EMSCRIPTEN_KEEPALIVE double* storeTotal() {
+    int consigned = 0;
+    int owned = 0;
+    double consignedValue = 0;
+    double ownedValue = 0;
+    int i = 0;
+#ifdef __wasm_simd128__
+    v128_t activeState = wasm_i8x16_splat('A');
+    v128_t consignedType = wasm_i8x16_splat('C');
+    v128_t consignedSum = wasm_f64x2_splat(0);
+    v128_t ownedSum = wasm_f64x2_splat(0);
+    for (; i + 16 <= store.count; i += 16) {
+        v128_t isActive = wasm_i8x16_eq(wasm_v128_load(store.states + i), activeState);
+        v128_t isConsigned = wasm_v128_and(isActive, wasm_i8x16_eq(wasm_v128_load(store.types + i), consignedType));
+        v128_t isOwned = wasm_v128_andnot(isActive, isConsigned);
+        consigned += __builtin_popcount(wasm_i8x16_bitmask(isConsigned));
+        owned += __builtin_popcount(wasm_i8x16_bitmask(isOwned));
+        // Widen the byte masks two lanes at a time to mask the values.
+        for (int j = 0; j < 16; j += 2) {
+            v128_t value = wasm_v128_load(store.values + i + j);
+            v128_t consignedMask = wasm_i64x2_extend_low_i32x4(wasm_i32x4_extend_low_i16x8(wasm_i16x8_extend_low_i8x16(isConsigned)));
+            v128_t ownedMask = wasm_i64x2_extend_low_i32x4(wasm_i32x4_extend_low_i16x8(wasm_i16x8_extend_low_i8x16(isOwned)));
+            consignedSum = wasm_f64x2_add(consignedSum, wasm_v128_and(value, consignedMask));
+            ownedSum = wasm_f64x2_add(ownedSum, wasm_v128_and(value, ownedMask));
+            isConsigned = wasm_i8x16_shuffle(isConsigned, isConsigned, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0, 1);
+            isOwned = wasm_i8x16_shuffle(isOwned, isOwned, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0, 1);
+        }
+    }
+    consignedValue = wasm_f64x2_extract_lane(consignedSum, 0) + wasm_f64x2_extract_lane(consignedSum, 1);
+    ownedValue = wasm_f64x2_extract_lane(ownedSum, 0) + wasm_f64x2_extract_lane(ownedSum, 1);
+#endif
+    for (; i < store.count; i++) {
+        if (store.states[i] == 'A') {
+            if (store.types[i] == 'C') {
+                consigned++;
+                consignedValue += store.values[i];
+            } else {
+                owned++;
+                ownedValue += store.values[i];
+            }
+        }
+    }
+    store.totals[0] = consigned;
+    store.totals[1] = owned;
+    store.totals[2] = consignedValue;
+    store.totals[3] = ownedValue;
+    return store.totals;
+}
+
+#else
+
 int main() {
     int option;
     do {
@@ -325,7 +1408,8 @@ int main() {
         printf("7 - Update a vehicle (value, state)\n");
         printf("8 - Remove a vehicle logically\n");
         printf("9 - Get total\n");
-        printf("10 - Exit\n");
+        printf("10 - Get totals by group (brand, model, year, type, state)\n");
+        printf("11 - Exit\n");
         printf("Enter your option: ");
         scanf("%d", &option);
 
@@ -677,6 +1761,39 @@ int main() {
                 break;
             }
             case 10: {
+                clearScreen();
+                char fields[6];
+                int groupBy = 0;
+                printf("Enter the fields to group by (B brand, M model, Y year, T type, S state): ");
+                scanf("%5s", fields);
+                for (int i = 0; fields[i] != '\0'; i++) {
+                    switch (fields[i]) {
+                        case 'B': groupBy |= GROUP_BY_BRAND; break;
+                        case 'M': groupBy |= GROUP_BY_MODEL; break;
+                        case 'Y': groupBy |= GROUP_BY_YEAR; break;
+                        case 'T': groupBy |= GROUP_BY_TYPE; break;
+                        case 'S': groupBy |= GROUP_BY_STATE; break;
+                    }
+                }
+                if (groupBy == 0) {
+                    printf("Invalid fields. Please try again.\n");
+                    printf("Press enter to continue...");
+                    getc(stdin);
+                    getc(stdin);
+                    clearScreen();
+                    break;
+                }
+                clearScreen();
+                GroupTable* table = groupVehicles(mainFile, groupBy);
+                printGroupTable(table);
+                freeGroupTable(table);
+                printf("Press enter to continue...");
+                getc(stdin);
+                getc(stdin);
+                clearScreen();
+                break;
+            }
+            case 11: {
                 clearScreen();
                 printf("Exiting...\n");
                 return 0;
@@ -696,3 +1813,5 @@ int main() {
 
     return 0;
 }
+
+#endif
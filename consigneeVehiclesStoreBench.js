@@ -0,0 +1,114 @@
+// Headless benchmark of the WebAssembly vehicle store.
+//
+// Build consigneeVehiclesStore.js/.wasm (-msimd128) and
+// consigneeVehiclesStoreScalar.js/.wasm (no -msimd128) as described in the
+// README, then run:
+//   node consigneeVehiclesStoreBench.js [numberOfVehicles]
+//
+// Both builds get the same vehicles. The timings of each are printed, and
+// the search results and totals of the SIMD build are checked against the
+// scalar one; the exit code is 1 if they differ.
+
+const numberOfVehicles = parseInt(process.argv[2] || '100000', 10);
+const repetitions = 50;
+const brands = ['Toyota', 'Mazda', 'Ford', 'Chevrolet', 'Renault', 'Kia'];
+const models = ['Sedan', 'Hatchback', 'Pickup', 'SUV'];
+const builds = [
+    ['SIMD', './consigneeVehiclesStore.js'],
+    ['Scalar', './consigneeVehiclesStoreScalar.js'],
+];
+const code = (c) => c.charCodeAt(0);
+
+async function benchBuild(name, modulePath) {
+    const store = await require(modulePath)();
+    const insert = store.cwrap('storeInsert', 'number',
+        ['string', 'string', 'string', 'number', 'string', 'number', 'number', 'number']);
+    const searchByNumberPlate = store.cwrap('storeSearchByNumberPlate', 'number', ['string']);
+    const searchByValueRange = store.cwrap('storeSearchByValueRange', 'number', ['number', 'number']);
+    const searchByBrandAndModel = store.cwrap('storeSearchByBrandAndModel', 'number', ['string', 'string']);
+    const searchByType = store.cwrap('storeSearchByType', 'number', ['number']);
+    const searchByState = store.cwrap('storeSearchByState', 'number', ['number']);
+    const total = store.cwrap('storeTotal', 'number', []);
+    const results = store.cwrap('storeResults', 'number', []);
+    const report = { searches: {}, totals: null };
+
+    console.log(`${name} build`);
+    let start = performance.now();
+    for (let i = 0; i < numberOfVehicles; i++) {
+        const numberPlate = 'V' + i.toString(36).toUpperCase().padStart(5, '0');
+        insert(numberPlate, brands[i % brands.length], models[i % models.length], 2000 + i % 25, 'White',
+            5000 + (i * 7919) % 95000 + (i % 100) / 100, code(i % 10 ? 'A' : 'E'), code(i % 3 ? 'P' : 'C'));
+    }
+    console.log(`  Insert ${numberOfVehicles} vehicles: ${(performance.now() - start).toFixed(1)} ms`);
+
+    // Times a search, then records how many vehicles it found and a
+    // checksum of their indices in storeResults.
+    const bench = (searchName, run) => {
+        let found = 0;
+        start = performance.now();
+        for (let i = 0; i < repetitions; i++) {
+            found = run();
+        }
+        const elapsed = (performance.now() - start) / repetitions;
+        console.log(`  ${searchName}: ${elapsed.toFixed(3)} ms (${found} found)`);
+        const first = results() >> 2;
+        let checksum = 0;
+        for (const index of store.HEAP32.subarray(first, first + found)) {
+            checksum = (checksum * 31 + index) >>> 0;
+        }
+        report.searches[searchName] = { found, checksum };
+    };
+
+    start = performance.now();
+    let index = -1;
+    for (let i = 0; i < repetitions; i++) {
+        index = searchByNumberPlate('V00ZZZ');
+    }
+    console.log(`  Search by number plate: ${((performance.now() - start) / repetitions).toFixed(3)} ms (index ${index})`);
+    report.searches['Search by number plate'] = { found: index, checksum: 0 };
+    bench('Search by value range', () => searchByValueRange(20000, 40000));
+    bench('Search by brand and model', () => searchByBrandAndModel('Ford', 'Pickup'));
+    bench('Search by type', () => searchByType(code('C')));
+    bench('Search by state', () => searchByState(code('A')));
+
+    start = performance.now();
+    for (let i = 0; i < repetitions; i++) {
+        total();
+    }
+    console.log(`  Get total: ${((performance.now() - start) / repetitions).toFixed(3)} ms`);
+    const first = total() >> 3;
+    report.totals = Array.from(store.HEAPF64.subarray(first, first + 4));
+    return report;
+}
+
+(async () => {
+    const reports = [];
+    for (const [name, modulePath] of builds) {
+        reports.push(await benchBuild(name, modulePath));
+    }
+
+    // The SIMD totals add the values in another order, so they may differ
+    // from the scalar ones in the last bits.
+    const [simd, scalar] = reports;
+    const mismatches = [];
+    for (const searchName of Object.keys(scalar.searches)) {
+        const a = simd.searches[searchName];
+        const b = scalar.searches[searchName];
+        if (a.found !== b.found || a.checksum !== b.checksum) {
+            mismatches.push(`${searchName}: ${a.found} found (SIMD) vs ${b.found} found (scalar)`);
+        }
+    }
+    ['Consigned vehicles', 'Owned vehicles', 'Consigned total value', 'Owned total value'].forEach((label, i) => {
+        const a = simd.totals[i];
+        const b = scalar.totals[i];
+        if (Math.abs(a - b) > 1e-9 * Math.max(1, Math.abs(b))) {
+            mismatches.push(`${label}: ${a} (SIMD) vs ${b} (scalar)`);
+        }
+    });
+    if (mismatches.length > 0) {
+        console.log('SIMD and scalar builds differ:');
+        mismatches.forEach((mismatch) => console.log(`  ${mismatch}`));
+        process.exit(1);
+    }
+    console.log('SIMD and scalar builds agree on every search and total.');
+})();
@@ -0,0 +1,48 @@
+// Persistence for the WebAssembly vehicle store, passed to emcc with
+// --pre-js. vehicles.dat lives in /data, which is an IDBFS mount loaded
+// from IndexedDB before the module is ready in the browser, and the current
+// directory (NODEFS) under Node.
+//
+//   Module.loadVehicles()  storeLoad of /data/vehicles.dat
+//   Module.flushVehicles() storeFlush of /data/vehicles.dat, then FS.syncfs
+//                          to IndexedDB; resolves with the storeFlush result
+
+var VEHICLES_DIRECTORY = '/data';
+var VEHICLES_PATH = VEHICLES_DIRECTORY + '/vehicles.dat';
+
+Module['preRun'] = [].concat(Module['preRun'] || []);
+Module['preRun'].push(function () {
+    FS.mkdir(VEHICLES_DIRECTORY);
+    if (ENVIRONMENT_IS_NODE) {
+        FS.mount(NODEFS, { root: '.' }, VEHICLES_DIRECTORY);
+        return;
+    }
+    FS.mount(IDBFS, {}, VEHICLES_DIRECTORY);
+    addRunDependency('loadVehicles');
+    FS.syncfs(true, function (error) {
+        if (error) {
+            err('Could not load the vehicles from IndexedDB: ' + error);
+        }
+        removeRunDependency('loadVehicles');
+    });
+});
+
+Module['loadVehicles'] = function () {
+    return ccall('storeLoad', 'number', ['string'], [VEHICLES_PATH]);
+};
+
+Module['flushVehicles'] = function () {
+    var result = ccall('storeFlush', 'number', ['string'], [VEHICLES_PATH]);
+    if (result !== 1 || ENVIRONMENT_IS_NODE) {
+        return Promise.resolve(result);
+    }
+    return new Promise(function (resolve, reject) {
+        FS.syncfs(false, function (error) {
+            if (error) {
+                reject(error);
+            } else {
+                resolve(result);
+            }
+        });
+    });
+};